@@ -0,0 +1,538 @@
+/*
+Copyright (c) 2017 ETH Zurich
+Sascha Brueck, Mauro Calderara, Mohammad Hossein Bani-Hashemian, and Mathieu Luisier
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*! \brief Standalone benchmark driver
+ *
+ *   Replays overlap and Hamiltonian matrices without CP2K, either from the binary dumps written by
+ *   write_scaled_cp2k_csr_bin (S in atomic units, H scaled to eV) or from a synthetic chain, and calls
+ *   c_scf_method for every solver combination listed in the description file.
+ *
+ *   Usage: mpiexec -np N transport_benchmark description.bench
+ *
+ *   The description file holds one KEY value pair per line, # starts a comment:
+ *     SYSTEM DUMP|CHAIN, S_FILE, H_FILE, N_ATOMS, ORBITALS, ZEFF, CONTACT_ATOMS, CONTACT_BANDWIDTH,
+ *     ONSITE, HOPPING, OVERLAP, RANGE, DECAY, SPLITTING, DISORDER (chain parameters in eV),
+ *     METHOD TRANSMISSION|TRANSPORT|SINGLE_POINT, TEMPERATURE (Kelvin), INJECTION_METHOD EVP|BEYN,
+ *     REAL_AXIS_INTEGRATION GC|TRAPEZOIDAL|ADAPTIVE, QT_FORMALISM WF|NEGF, FERMI_NEUTRAL, NUM_POLE, N_KPOINT,
+ *     NUM_INTERVAL, ENERGY_INTERVAL, MIN_INTERVAL, EPS_LIMIT, EPS_LIMIT_CC, EPS_DECAY, EPS_SINGULARITY_CURVATURES,
+ *     EPS_MU, EPS_EIGVAL_DEGEN, EPS_FERMI, N_POINTS_BEYN, NCRC_BEYN, N_POINTS_INV, TASKS_PER_ENERGY_POINT,
+ *     TASKS_PER_POLE, SOLVER <linear solver> <inversion method> (repeatable), REPEAT,
+ *     KEEP_CACHES 0|1 (keep the mixing history and the caches of c_scf_method from one run to the next, by default
+ *     every run starts cold),
+ *     SCF_ITERATIONS, HUBBARD_U (eV), DENS_MIXING (every run is a self-consistent cycle of SCF_ITERATIONS calls, after
+ *     each call H is H0 plus the mean field HUBBARD_U*(Mulliken charge-ZEFF) of the atoms, see update_hubbard)
+ *   and any key of TransportSettings (SIGMA_CACHE_SIZE, EPS_SIGMA_CACHE, EPS_SIGMA_INV, EPS_SINGLE_INV, SINGLE_INV_MIN_IMAG,
+ *   REAL_INT_METHOD GC|TRAPEZOIDAL|READFROMFILE|ADAPTIVE, EPS_REAL_INT, N_KPOINT_REFINE, DOS_COMPACT 0|1, BLOCK_SPARSE 0|1,
+ *   RGF_BATCH_SIZE, MIXING_METHOD LINEAR|PULAY|BROYDEN, MIXING_HISTORY, MIXING_SPILL 0|1, TIMING 0|1 (region report),
+ *   TRACE 0|1 (Trace_<run>.json, runs are numbered over all solvers)), which is passed on to c_scf_method and overrides
+ *   REAL_AXIS_INTEGRATION.
+ */
+
+#include <mpi.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "libcp2k.h"
+#include "CSR.H"
+#include "Utilities.H"
+#include "EnergyVector.H"
+#include "TransportSettings.H"
+
+void c_scf_method(
+    cp2k_transport_parameters cp2k_transport_params,
+    cp2k_csr_interop_type S,
+    cp2k_csr_interop_type KS,
+    cp2k_csr_interop_type* P,
+    cp2k_csr_interop_type* PImag
+    );
+void c_scf_reset();
+
+#ifdef HAVE_OMEN_POISSON
+// defined by main.cpp for the full executable, the library refers to them but the benchmark never sets up Poisson
+#include "Types.H"
+#include "InputParameter.H"
+#include "WireGenerator.H"
+#include "FEMGrid.H"
+#include "Poisson.H"
+PARAM *parameter;
+WireStructure *nanowire;
+ENERGY *En;
+VOLTAGE *voltage;
+WireGenerator* Wire;
+FEMGrid *FEM;
+Poisson *OMEN_Poisson_Solver;
+#endif
+
+// CODATA 2018, the same constants CP2K hands over in cp2k_transport_parameters
+static const double HARTREE_EV   = 27.211386245988;
+static const double E_CHARGE     = 1.602176634E-19;
+static const double BOLTZMANN    = 1.380649E-23;
+static const double H_BAR        = 1.054571817E-34;
+
+/*! \brief Contents of the benchmark description file
+ */
+struct benchmark_input {
+    std::map<std::string,std::string> keys;
+    std::vector< std::pair<std::string,std::string> > solvers;
+    std::string get(const std::string &key,const std::string &def) const {
+        std::map<std::string,std::string>::const_iterator it=keys.find(key);
+        return it==keys.end() ? def : it->second;
+    }
+    double get(const std::string &key,double def) const {
+        std::map<std::string,std::string>::const_iterator it=keys.find(key);
+        return it==keys.end() ? def : atof(it->second.c_str());
+    }
+    int get(const std::string &key,int def) const {
+        std::map<std::string,std::string>::const_iterator it=keys.find(key);
+        return it==keys.end() ? def : atoi(it->second.c_str());
+    }
+};
+
+int read_input(const char *filename,benchmark_input &input)
+{
+    ifstream infile(filename);
+    if (infile.fail()) return (LOGCERR, EXIT_FAILURE);
+    std::string line;
+    while (getline(infile,line)) {
+        line=line.substr(0,line.find('#'));
+        istringstream linestream(line);
+        std::string key,value;
+        if (!(linestream >> key)) continue;
+        transform(key.begin(),key.end(),key.begin(),::toupper);
+        if (key=="SOLVER") {
+            std::string lin,inv;
+            if (!(linestream >> lin >> inv)) return (LOGCERR, EXIT_FAILURE);
+            transform(lin.begin(),lin.end(),lin.begin(),::toupper);
+            transform(inv.begin(),inv.end(),inv.begin(),::toupper);
+            input.solvers.push_back(std::make_pair(lin,inv));
+        } else {
+            if (!(linestream >> value)) value="1";
+            input.keys[key]=value;
+        }
+    }
+    if (!input.solvers.size()) input.solvers.push_back(std::make_pair(std::string("FULL"),std::string("FULL")));
+    return 0;
+}
+
+int solver_enums(const std::pair<std::string,std::string> &solver,int &linear_solver,int &matrixinv_method)
+{
+    std::map<std::string,int> lin;
+    lin["SPLITSOLVE"]=lin_solver_methods::SPLITSOLVE;
+    lin["SUPERLU"]=lin_solver_methods::SUPERLU;
+    lin["MUMPS"]=lin_solver_methods::MUMPS;
+    lin["FULL"]=lin_solver_methods::FULL;
+    lin["BANDED"]=lin_solver_methods::BANDED;
+    lin["PARDISO"]=lin_solver_methods::PARDISO;
+    lin["UMFPACK"]=lin_solver_methods::UMFPACK;
+    std::map<std::string,int> inv;
+    inv["FULL"]=inv_solver_methods::FULL;
+    inv["PEXSI"]=inv_solver_methods::PEXSI;
+    inv["PARDISO"]=inv_solver_methods::PARDISO;
+    inv["RGF"]=inv_solver_methods::RGF;
+    if (!lin.count(solver.first) || !inv.count(solver.second)) return (LOGCERR, EXIT_FAILURE);
+    linear_solver=lin[solver.first];
+    matrixinv_method=inv[solver.second];
+    return 0;
+}
+
+/*! \brief Atoms are distributed evenly over the ranks, as CP2K never splits the rows of an atom
+ */
+void local_atoms(int n_atoms,int rank,int mpi_size,int &atom_start,int &atom_end)
+{
+    atom_start=int((long(n_atoms)*rank)/mpi_size);
+    atom_end=int((long(n_atoms)*(rank+1))/mpi_size);
+}
+
+void allocate_cp2k_csr(cp2k_csr_interop_type &mat,int nrows_total,int nrows_local,int first_row,std::vector<int> &rowptr,std::vector<int> &colind,MPI_Comm comm)
+{
+    mat.nrows_total  = nrows_total;
+    mat.ncols_total  = nrows_total;
+    mat.nrows_local  = nrows_local;
+    mat.first_row    = first_row;
+    mat.nze_local    = colind.size();
+    mat.data_type    = 1;
+    MPI_Allreduce(&mat.nze_local,&mat.nze_total,1,MPI_INT,MPI_SUM,comm);
+    mat.rowptr_local = new int[nrows_local+1];
+    mat.nzerow_local = new int[nrows_local];
+    mat.colind_local = new int[max(mat.nze_local,1)];
+    mat.nzvals_local = new double[max(mat.nze_local,1)]();
+    for (int i=0;i<=nrows_local;i++) mat.rowptr_local[i]=rowptr[i]+1;
+    for (int i=0;i<nrows_local;i++) mat.nzerow_local[i]=rowptr[i+1]-rowptr[i];
+    for (int e=0;e<mat.nze_local;e++) mat.colind_local[e]=colind[e]+1;
+}
+
+void delete_cp2k_csr(cp2k_csr_interop_type &mat)
+{
+    delete[] mat.rowptr_local;
+    delete[] mat.nzerow_local;
+    delete[] mat.colind_local;
+    delete[] mat.nzvals_local;
+}
+
+/*! \brief Read the local rows [first_row,first_row+nrows_local) of a dump written by write_scaled_cp2k_csr_bin
+ *
+ *   The dump is a header of three doubles (size, nonzeros, index base) followed by (row,col,real,imag) records
+ *   ordered by row, so the local records are found by bisection on the row of each record.
+ */
+int read_csr_bin_rows(const char *filename,int first_row,int nrows_local,int &size_tot,std::vector<int> &rowptr,std::vector<int> &colind,std::vector<double> &values)
+{
+    ifstream binfile(filename,ios::in|ios::binary);
+    if (binfile.fail()) return (LOGCERR, EXIT_FAILURE);
+    double head[3];
+    binfile.read((char*)head,3*sizeof(double));
+    size_tot=int(head[0]);
+    long n_nonzeros=long(head[1]);
+    int findx=int(head[2]);
+    double record[4];
+    long lo=0;
+    long hi=n_nonzeros;
+    while (lo<hi) {
+        long mid=(lo+hi)/2;
+        binfile.seekg((3+4*mid)*sizeof(double),ios::beg);
+        binfile.read((char*)record,4*sizeof(double));
+        if (int(record[0])-findx<first_row) lo=mid+1; else hi=mid;
+    }
+    binfile.seekg((3+4*lo)*sizeof(double),ios::beg);
+    std::vector< std::vector< std::pair<int,double> > > rows(nrows_local);
+    for (long e=lo;e<n_nonzeros;e++) {
+        binfile.read((char*)record,4*sizeof(double));
+        int irow=int(record[0])-findx-first_row;
+        if (irow>=nrows_local) break;
+        if (irow<0 || binfile.fail()) return (LOGCERR, EXIT_FAILURE);
+        rows[irow].push_back(std::make_pair(int(record[1])-findx,record[2]));
+    }
+    binfile.close();
+    rowptr.assign(1,0);
+    colind.clear();
+    values.clear();
+    for (int i=0;i<nrows_local;i++) {
+        sort(rows[i].begin(),rows[i].end());
+        for (uint e=0;e<rows[i].size();e++) {
+            colind.push_back(rows[i][e].first);
+            values.push_back(rows[i][e].second);
+        }
+        rowptr.push_back(colind.size());
+    }
+    return 0;
+}
+
+/*! \brief Pseudo random number in [0,1) that only depends on the atom, so the system is independent of the number of ranks
+ */
+double atom_random(int atom)
+{
+    unsigned long x=2654435761UL*(atom+1);
+    x^=x>>13;
+    x*=1274126177UL;
+    x^=x>>16;
+    return double(x%1000003UL)/1000003.0;
+}
+
+/*! \brief Local rows of a linear chain with ORBITALS orbitals per atom and couplings up to RANGE neighbours
+ *
+ *   The on-site disorder is restricted to atoms further than two contact bandwidths from the ends, so that
+ *   the contact unit cells stay periodic.
+ */
+void build_chain(const benchmark_input &input,int atom_start,int atom_end,std::vector<int> &rowptr,std::vector<int> &colind,std::vector<double> &overlap,std::vector<double> &hamiltonian)
+{
+    int n_atoms      = input.get("N_ATOMS",60);
+    int norb         = input.get("ORBITALS",1);
+    int range        = input.get("RANGE",1);
+    int n_contact    = input.get("CONTACT_ATOMS",range);
+    double onsite    = input.get("ONSITE",0.0)/HARTREE_EV;
+    double hopping   = input.get("HOPPING",-2.7)/HARTREE_EV;
+    double s_hopping = input.get("OVERLAP",0.0);
+    double decay     = input.get("DECAY",0.3);
+    double splitting = input.get("SPLITTING",1.0)/HARTREE_EV;
+    double disorder  = input.get("DISORDER",0.0)/HARTREE_EV;
+    int margin       = 2*((range+n_contact-1)/n_contact)*n_contact;
+    rowptr.assign(1,0);
+    for (int a=atom_start;a<atom_end;a++) {
+        double shift=0.0;
+        if (a>=margin && a<n_atoms-margin) shift=disorder*(atom_random(a)-0.5);
+        for (int i=0;i<norb;i++) {
+            for (int b=max(0,a-range);b<=min(n_atoms-1,a+range);b++) {
+                double fac=pow(decay,abs(b-a)-1);
+                for (int j=0;j<norb;j++) {
+                    double coupling=1.0/(1.0+abs(i-j));
+                    colind.push_back(b*norb+j);
+                    if (a==b) {
+                        overlap.push_back(i==j ? 1.0 : 0.0);
+                        hamiltonian.push_back(i==j ? onsite+shift+splitting*(i-0.5*(norb-1)) : 0.1*hopping*coupling);
+                    } else {
+                        overlap.push_back(s_hopping*fac*coupling);
+                        hamiltonian.push_back(hopping*fac*coupling);
+                    }
+                }
+            }
+            rowptr.push_back(colind.size());
+        }
+    }
+}
+
+/*! \brief Peak resident memory in MB since the last call to reset_peak_memory
+ */
+double peak_memory()
+{
+    ifstream status("/proc/self/status");
+    std::string line;
+    while (getline(status,line)) {
+        if (line.compare(0,6,"VmHWM:")==0) return atof(line.substr(6).c_str())/1024.0;
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF,&usage);
+    return usage.ru_maxrss/1024.0;
+}
+
+void reset_peak_memory()
+{
+    ofstream clear_refs("/proc/self/clear_refs");
+    if (!clear_refs.fail()) clear_refs << "5" << endl;
+}
+
+/*! \brief Mulliken charges of P and a mean field on-site interaction U*(charge-zeff) of every atom added to H0
+ *
+ *   The shift of an element between atoms a and b is the average shift of both atoms times the overlap element,
+ *   returns the Mulliken charges of all atoms
+ */
+std::vector<double> update_hubbard(cp2k_csr_interop_type &S,cp2k_csr_interop_type &P,cp2k_csr_interop_type &KS,const std::vector<double> &hamiltonian_0,const std::vector<double> &zeff,int norb,double hubbard_u)
+{
+    int n_atoms=zeff.size();
+    std::vector<double> charge(n_atoms,0.0);
+    for (int i=0;i<S.nrows_local;i++) {
+        for (int e=S.rowptr_local[i]-1;e<S.rowptr_local[i+1]-1;e++) {
+            charge[(S.first_row+i)/norb]+=2.0*S.nzvals_local[e]*P.nzvals_local[e];
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE,&charge[0],n_atoms,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);
+    for (int i=0;i<S.nrows_local;i++) {
+        double shift_i=hubbard_u*(charge[(S.first_row+i)/norb]-zeff[(S.first_row+i)/norb]);
+        for (int e=S.rowptr_local[i]-1;e<S.rowptr_local[i+1]-1;e++) {
+            int atom_j=(S.colind_local[e]-1)/norb;
+            double shift_j=hubbard_u*(charge[atom_j]-zeff[atom_j]);
+            KS.nzvals_local[e]=hamiltonian_0[e]+0.5*(shift_i+shift_j)*S.nzvals_local[e];
+        }
+    }
+    return charge;
+}
+
+int main (int argc, char **argv)
+{
+    MPI_Init(&argc,&argv);
+    int rank,mpi_size;
+    MPI_Comm_size(MPI_COMM_WORLD,&mpi_size);
+    MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+
+    benchmark_input input;
+    if (argc<2 || read_input(argv[1],input)) {
+        if (!rank) cerr << "Usage: " << argv[0] << " description.bench" << endl;
+        MPI_Abort(MPI_COMM_WORLD,EXIT_FAILURE);
+    }
+
+double sabtime=get_time(0.0);
+    std::string system=input.get("SYSTEM",std::string("CHAIN"));
+    int n_atoms=input.get("N_ATOMS",60);
+    int norb=input.get("ORBITALS",1);
+    int atom_start,atom_end;
+    local_atoms(n_atoms,rank,mpi_size,atom_start,atom_end);
+    int first_row=atom_start*norb;
+    int nrows_local=(atom_end-atom_start)*norb;
+    int size_tot=n_atoms*norb;
+    std::vector<int> rowptr,colind;
+    std::vector<double> overlap,hamiltonian;
+    if (system=="DUMP") {
+        std::vector<int> rowptr_h,colind_h;
+        int size_h;
+        if (read_csr_bin_rows(input.get("S_FILE",std::string("S_4.bin")).c_str(),first_row,nrows_local,size_tot,rowptr,colind,overlap)) MPI_Abort(MPI_COMM_WORLD,EXIT_FAILURE);
+        if (read_csr_bin_rows(input.get("H_FILE",std::string("H_4.bin")).c_str(),first_row,nrows_local,size_h,rowptr_h,colind_h,hamiltonian)) MPI_Abort(MPI_COMM_WORLD,EXIT_FAILURE);
+        if (size_tot!=n_atoms*norb || size_h!=size_tot || rowptr_h!=rowptr || colind_h!=colind) {
+            if (!rank) cerr << "S and H dumps must share one sparsity pattern of N_ATOMS*ORBITALS rows" << endl;
+            MPI_Abort(MPI_COMM_WORLD,EXIT_FAILURE);
+        }
+        for (uint e=0;e<hamiltonian.size();e++) hamiltonian[e]/=HARTREE_EV;
+    } else if (system=="CHAIN") {
+        build_chain(input,atom_start,atom_end,rowptr,colind,overlap,hamiltonian);
+    } else {
+        if (!rank) cerr << "Unknown SYSTEM " << system << endl;
+        MPI_Abort(MPI_COMM_WORLD,EXIT_FAILURE);
+    }
+    cp2k_csr_interop_type S,KS,P,PImag;
+    allocate_cp2k_csr(S    ,size_tot,nrows_local,first_row,rowptr,colind,MPI_COMM_WORLD);
+    allocate_cp2k_csr(KS   ,size_tot,nrows_local,first_row,rowptr,colind,MPI_COMM_WORLD);
+    allocate_cp2k_csr(P    ,size_tot,nrows_local,first_row,rowptr,colind,MPI_COMM_WORLD);
+    allocate_cp2k_csr(PImag,size_tot,nrows_local,first_row,rowptr,colind,MPI_COMM_WORLD);
+    copy(overlap.begin(),overlap.end(),S.nzvals_local);
+    copy(hamiltonian.begin(),hamiltonian.end(),KS.nzvals_local);
+    overlap=std::vector<double>();
+    hamiltonian=std::vector<double>();
+if (!rank) cout << "TIME FOR LOADING MATRICES " << get_time(sabtime) << endl;
+    if (!rank) cout << "BENCHMARK SYSTEM " << system << " ATOMS " << n_atoms << " ORBITALS " << size_tot << " NONZEROS " << S.nze_total << " RANKS " << mpi_size << endl;
+
+    std::vector<int> nsgf(n_atoms,norb);
+    std::vector<double> zeff(n_atoms,input.get("ZEFF",double(norb)));
+    int n_contact=input.get("CONTACT_ATOMS",input.get("RANGE",1));
+    int stride=5;
+    std::vector<int> contacts_data(2*stride);
+    for (int i_c=0;i_c<2;i_c++) {
+        contacts_data[0+stride*i_c]=input.get("CONTACT_BANDWIDTH",0);
+        contacts_data[1+stride*i_c]=-1;
+        contacts_data[2+stride*i_c]=n_contact;
+        contacts_data[3+stride*i_c]=1-2*i_c;
+        contacts_data[4+stride*i_c]=1;
+    }
+
+    cp2k_transport_parameters params;
+    params.n_atoms                     = n_atoms;
+    params.n_occ                       = int(accumulate(zeff.begin(),zeff.end(),0.0)/2.0);
+    params.energy_diff                 = 0.0;
+    params.evoltfactor                 = HARTREE_EV;
+    params.e_charge                    = E_CHARGE;
+    params.boltzmann                   = BOLTZMANN;
+    params.h_bar                       = H_BAR;
+    params.iscf                        = 1;
+    params.method                      = cp2k_methods::TRANSMISSION;
+    params.qt_formalism                = input.get("QT_FORMALISM",std::string("WF"))=="NEGF" ? 41 : 42;
+    params.injection_method            = input.get("INJECTION_METHOD",std::string("BEYN"))=="EVP" ? injection_methods::EVP : injection_methods::BEYN;
+    params.rlaxis_integration_method   = real_int_methods::GAUSSCHEBYSHEV;
+    params.transport_neutral           = input.get("FERMI_NEUTRAL",0) ? 52 : 51;
+    params.num_pole                    = input.get("NUM_POLE",64);
+    params.ordering                    = 0;
+    params.row_ordering                = 0;
+    params.verbosity                   = 0;
+    params.pexsi_np_symb_fact          = 0;
+    params.n_kpoint                    = input.get("N_KPOINT",64);
+    params.num_interval                = input.get("NUM_INTERVAL",10);
+    params.num_contacts                = 2;
+    params.stride_contacts             = stride;
+    params.tasks_per_energy_point      = input.get("TASKS_PER_ENERGY_POINT",1);
+    params.tasks_per_pole              = input.get("TASKS_PER_POLE",1);
+    params.gpus_per_point              = 0;
+    params.n_points_beyn               = input.get("N_POINTS_BEYN",64);
+    params.ncrc_beyn                   = input.get("NCRC_BEYN",1);
+    params.tasks_per_integration_point = 0;
+    params.n_points_inv                = input.get("N_POINTS_INV",64);
+    params.cutout[0]                   = 0;
+    params.cutout[1]                   = 0;
+    params.colzero_threshold           = 1.0E-12;
+    params.eps_limit                   = input.get("EPS_LIMIT",1.0E-4);
+    params.eps_limit_cc                = input.get("EPS_LIMIT_CC",1.0E-6);
+    params.eps_decay                   = input.get("EPS_DECAY",1.0E-4);
+    params.eps_singularity_curvatures  = input.get("EPS_SINGULARITY_CURVATURES",1.0E-12);
+    params.eps_mu                      = input.get("EPS_MU",1.0E-6);
+    params.eps_eigval_degen            = input.get("EPS_EIGVAL_DEGEN",1.0E-6);
+    params.eps_fermi                   = input.get("EPS_FERMI",0.0);
+    params.energy_interval             = input.get("ENERGY_INTERVAL",1.0E-2);
+    params.min_interval                = input.get("MIN_INTERVAL",1.0E-4);
+    params.temperature                 = input.get("TEMPERATURE",300.0)*BOLTZMANN/(E_CHARGE*HARTREE_EV);
+    params.dens_mixing                 = input.get("DENS_MIXING",1.0);
+    params.n_rand_beyn                 = 1.0;
+    params.n_rand_cc_beyn              = 1.0;
+    params.svd_cutoff                  = 1.0;
+    params.contacts_data               = &contacts_data[0];
+    params.nsgf                        = &nsgf[0];
+    params.zeff                        = &zeff[0];
+    params.obc_equilibrium             = false;
+    params.extra_scf                   = false;
+    std::string method=input.get("METHOD",std::string("TRANSMISSION"));
+    if (method=="TRANSPORT") {
+        params.method                  = cp2k_methods::TRANSPORT;
+    } else if (method=="SINGLE_POINT") {
+// one real axis point at the average chemical potential, see Energyvector::determine_energyvector
+        params.extra_scf               = true;
+        params.energy_interval         = 0.0;
+    } else if (method!="TRANSMISSION") {
+        if (!rank) cerr << "Unknown METHOD " << method << endl;
+        MPI_Abort(MPI_COMM_WORLD,EXIT_FAILURE);
+    }
+    std::string rlaxis=input.get("REAL_AXIS_INTEGRATION",std::string("GC"));
+    if (rlaxis=="TRAPEZOIDAL") params.rlaxis_integration_method = real_int_methods::TRAPEZOIDAL;
+    if (rlaxis=="ADAPTIVE")    params.rlaxis_integration_method = real_int_methods::ADAPTIVE;
+
+    int repeat=max(1,input.get("REPEAT",1));
+    int keep_caches=input.get("KEEP_CACHES",0);
+    int scf_iterations=max(1,input.get("SCF_ITERATIONS",1));
+    double hubbard_u=input.get("HUBBARD_U",0.0)/HARTREE_EV;
+    std::vector<double> hamiltonian_0(KS.nzvals_local,KS.nzvals_local+KS.nze_local);
+    for (std::map<std::string,std::string>::const_iterator it=input.keys.begin();it!=input.keys.end();it++) {
+        if (TransportSettings::Known(it->first) && TransportSettings::Set(it->first,it->second)) {
+            if (!rank) cerr << "Invalid value " << it->second << " for " << it->first << endl;
+            MPI_Abort(MPI_COMM_WORLD,EXIT_FAILURE);
+        }
+    }
+    for (uint i_s=0;i_s<input.solvers.size();i_s++) {
+        if (solver_enums(input.solvers[i_s],params.linear_solver,params.matrixinv_method)) {
+            if (!rank) cerr << "Unknown SOLVER " << input.solvers[i_s].first << " " << input.solvers[i_s].second << endl;
+            MPI_Abort(MPI_COMM_WORLD,EXIT_FAILURE);
+        }
+        std::string name=input.solvers[i_s].first+"/"+input.solvers[i_s].second;
+        std::vector<double> runtime;
+        long n_points=0;
+        reset_peak_memory();
+        for (int r=0;r<repeat;r++) {
+            fill(P.nzvals_local,P.nzvals_local+P.nze_local,0.0);
+            fill(PImag.nzvals_local,PImag.nzvals_local+PImag.nze_local,0.0);
+            copy(hamiltonian_0.begin(),hamiltonian_0.end(),KS.nzvals_local);
+            long points_before=Energyvector::points_evaluated;
+            if (!keep_caches) c_scf_reset();
+            MPI_Barrier(MPI_COMM_WORLD);
+sabtime=get_time(0.0);
+            std::vector<double> charge_previous(n_atoms,0.0);
+            for (int i_scf=0;i_scf<scf_iterations;i_scf++) {
+// a self-consistent run numbers its iterations from 1 like a CP2K SCF cycle, which restarts the density mixing
+                params.iscf=scf_iterations>1 ? i_scf+1 : i_s*repeat+r+1;
+                try {
+                    c_scf_method(params,S,KS,&P,&PImag);
+                } catch (std::exception &e) {
+                    cerr << "Solver " << name << " failed on rank " << rank << endl;
+                    MPI_Abort(MPI_COMM_WORLD,EXIT_FAILURE);
+                }
+                if (scf_iterations>1) {
+                    std::vector<double> charge=update_hubbard(S,P,KS,hamiltonian_0,zeff,norb,hubbard_u);
+                    double change=0.0;
+                    for (int a=0;a<n_atoms;a++) change=max(change,abs(charge[a]-charge_previous[a]));
+                    charge_previous=charge;
+                    if (!rank) cout << "BENCHMARK SCF ITERATION " << i_scf+1 << " MAX CHARGE CHANGE " << change << endl;
+// c_scf_method halves the spin summed density it gets and returns the density of one spin
+                    for (int e=0;e<P.nze_local;e++) P.nzvals_local[e]*=2.0;
+                }
+            }
+            MPI_Barrier(MPI_COMM_WORLD);
+            runtime.push_back(get_time(sabtime));
+            n_points=Energyvector::points_evaluated-points_before;
+if (!rank) cout << "TIME FOR BENCHMARK RUN " << r+1 << " OF " << name << " " << runtime[r] << endl;
+        }
+        double mem_local=peak_memory();
+        double mem_max,mem_sum;
+        MPI_Reduce(&mem_local,&mem_max,1,MPI_DOUBLE,MPI_MAX,0,MPI_COMM_WORLD);
+        MPI_Reduce(&mem_local,&mem_sum,1,MPI_DOUBLE,MPI_SUM,0,MPI_COMM_WORLD);
+        if (!rank) {
+            double t_min=*min_element(runtime.begin(),runtime.end());
+            double t_max=*max_element(runtime.begin(),runtime.end());
+            double t_avg=accumulate(runtime.begin(),runtime.end(),0.0)/runtime.size();
+            cout << "BENCHMARK " << name << " RUNS " << repeat << " TIME MIN " << t_min << " AVG " << t_avg << " MAX " << t_max;
+            cout << " POINTS " << n_points << " POINTS PER SECOND " << (t_avg>0.0 ? n_points/t_avg : 0.0);
+            cout << " PEAK MEMORY MB MAX " << mem_max << " SUM " << mem_sum << endl;
+        }
+    }
+
+    delete_cp2k_csr(S);
+    delete_cp2k_csr(KS);
+    delete_cp2k_csr(P);
+    delete_cp2k_csr(PImag);
+    MPI_Finalize();
+    return 0;
+}
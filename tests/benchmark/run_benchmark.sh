@@ -0,0 +1,78 @@
+#!/bin/bash -e
+
+NP=${NP:-2}
+BENCHMARK=${BENCHMARK:-transport_benchmark}
+TOLERANCE=${TOLERANCE:-1E-5}
+SCF_TOLERANCE=${SCF_TOLERANCE:-1E-4}
+ADAPTIVE_TOLERANCE=${ADAPTIVE_TOLERANCE:-1E-3}
+
+failed=0
+for system in chain ladder; do
+    mkdir -p $system
+    cd $system
+    rm -f Mulliken_*
+    mpiexec -np $NP $BENCHMARK ../$system.bench | tee benchmark.out
+    grep "^BENCHMARK" benchmark.out
+# every run of every solver has to reproduce the Mulliken charges of the reference
+    for mulliken in Mulliken_*; do
+        diff=$(paste ../reference/$system.Mulliken $mulliken | awk 'BEGIN{m=0} {d=$1-$2; if (d<0) d=-d; if (d>m) m=d} END{print m}')
+        if awk "BEGIN{exit !($diff<=$TOLERANCE)}"; then
+            echo "REFERENCE $system $mulliken PASSED, MAX DIFFERENCE $diff"
+        else
+            echo "REFERENCE $system $mulliken FAILED, MAX DIFFERENCE $diff"
+            failed=1
+        fi
+    done
+    cd ..
+done
+# the single point only computes the transmission and the DOS of its energy, P is not brought back to CP2K, so its
+# transmission is checked instead of the Mulliken charges
+mkdir -p single_point
+cd single_point
+rm -f Transmission_*
+mpiexec -np $NP $BENCHMARK ../single_point.bench | tee benchmark.out
+grep "^BENCHMARK" benchmark.out
+for transmission in Transmission_*; do
+    diff=$(paste ../reference/single_point.Transmission $transmission | awk 'BEGIN{m=0} {d=$1-$4; if (d<0) d=-d; if (d>m) m=d; d=$3-$6; if (d<0) d=-d; if (d>m) m=d} END{print m}')
+    if awk "BEGIN{exit !($diff<=$TOLERANCE)}"; then
+        echo "REFERENCE single_point $transmission PASSED, MAX DIFFERENCE $diff"
+    else
+        echo "REFERENCE single_point $transmission FAILED, MAX DIFFERENCE $diff"
+        failed=1
+    fi
+done
+cd ..
+# the adaptive grid has to reproduce the Gauss-Chebyshev charges of the ladder within the discretization error of the
+# Gauss-Chebyshev grid, which itself moves by 7E-4 between MIN_INTERVAL 1E-4 and 1E-6
+mkdir -p adaptive
+cd adaptive
+rm -f Mulliken_*
+mpiexec -np $NP $BENCHMARK ../adaptive.bench | tee benchmark.out
+grep "^ADAPTIVE REAL AXIS GRID" benchmark.out
+for mulliken in Mulliken_*; do
+    diff=$(paste ../reference/ladder.Mulliken $mulliken | awk 'BEGIN{m=0} {d=$1-$2; if (d<0) d=-d; if (d>m) m=d} END{print m}')
+    if awk "BEGIN{exit !($diff<=$ADAPTIVE_TOLERANCE)}"; then
+        echo "REFERENCE adaptive $mulliken PASSED, MAX DIFFERENCE $diff"
+    else
+        echo "REFERENCE adaptive $mulliken FAILED, MAX DIFFERENCE $diff"
+        failed=1
+    fi
+done
+cd ..
+# the self-consistent cycles have to bring the density residual of the last iteration below SCF_TOLERANCE
+for system in scf_pulay scf_broyden; do
+    mkdir -p $system
+    cd $system
+    mpiexec -np $NP $BENCHMARK ../$system.bench | tee benchmark.out
+    residual=$(grep "^DENSITY RESIDUAL" benchmark.out | tail -1 | awk '{print $3}')
+    if awk "BEGIN{exit !($residual<=$SCF_TOLERANCE)}"; then
+        echo "SCF $system PASSED, FINAL RESIDUAL $residual"
+    else
+        echo "SCF $system FAILED, FINAL RESIDUAL $residual"
+        failed=1
+    fi
+    cd ..
+done
+exit $failed
+
+#EOF
@@ -0,0 +1,161 @@
+/*
+Copyright (c) 2017 ETH Zurich
+Sascha Brueck, Mauro Calderara, Mohammad Hossein Bani-Hashemian, and Mathieu Luisier
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*! \brief Compare tmprGF::sparse_invert with a dense LAPACK inverse
+ *
+ *   Complex symmetric block tridiagonal matrices are inverted for several energies and two block layouts, so the
+ *   workspace kept between calls is reused, grown and shrunk. The elements on the sparsity pattern must agree with
+ *   the dense inverse to within 1E-10 relative to the largest element. Batches of energies inverted together on the
+ *   OpenMP threads must agree with one inversion per energy to within 1E-12.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <omp.h>
+#include "tmprGF.H"
+
+double atom_random(int i)
+{
+    unsigned long x=2654435761UL*(i+1);
+    x^=x>>13;
+    x*=1274126177UL;
+    x^=x>>16;
+    return double(x%1000003UL)/1000003.0;
+}
+
+int block_of(const std::vector<int> &Bstart,int row)
+{
+    int block=0;
+    while (block+1<int(Bstart.size()) && row>=Bstart[block+1]) block++;
+    return block;
+}
+
+TCSR<CPX>* block_tridiagonal(const std::vector<int> &Bsizes,CPX energy,std::vector<CPX> &dense)
+{
+    int N=0;
+    std::vector<int> Bstart;
+    for (uint i=0;i<Bsizes.size();i++) {
+        Bstart.push_back(N);
+        N+=Bsizes[i];
+    }
+    dense.assign(N*N,CPX(0.0,0.0));
+    for (int r=0;r<N;r++) {
+        for (int c=0;c<=r;c++) {
+            if (abs(block_of(Bstart,r)-block_of(Bstart,c))>1) continue;
+            CPX value=CPX(atom_random(r*N+c)-0.5,0.0);
+            if (r==c) value+=4.0-energy;
+            dense[r*N+c]=value;
+            dense[c*N+r]=value;
+        }
+    }
+    int nnz=0;
+    for (int i=0;i<N*N;i++) if (dense[i]!=CPX(0.0,0.0)) nnz++;
+    TCSR<CPX> *A=new TCSR<CPX>(N,nnz,0);
+    int e=0;
+    for (int r=0;r<N;r++) {
+        A->index_i[r]=0;
+        for (int c=0;c<N;c++) {
+            if (dense[r*N+c]!=CPX(0.0,0.0)) {
+                A->index_j[e]=c;
+                A->nnz[e]=dense[r*N+c];
+                A->index_i[r]++;
+                e++;
+            }
+        }
+    }
+    A->get_row_edge();
+    return A;
+}
+
+double check_layout(const std::vector<int> &Bsizes,CPX energy)
+{
+    std::vector<CPX> dense;
+    TCSR<CPX> *A=block_tridiagonal(Bsizes,energy,dense);
+    int N=A->size;
+    tmprGF::sparse_invert(A,Bsizes);
+
+// the matrix is symmetric, so the row major array is its own transpose
+    std::vector<int> pivot(N);
+    int info;
+    c_zgetrf(N,N,&dense[0],N,&pivot[0],&info);
+    std::vector<CPX> inverse(N*N,CPX(0.0,0.0));
+    for (int i=0;i<N;i++) inverse[i*N+i]=CPX(1.0,0.0);
+    c_zgetrs('N',N,N,&dense[0],N,&pivot[0],&inverse[0],N,&info);
+    double max_error=0.0;
+    double max_element=0.0;
+    for (int r=0;r<N;r++) {
+        for (int e=A->edge_i[r];e<A->edge_i[r+1];e++) {
+            max_error=max(max_error,abs(A->nnz[e]-inverse[r*N+A->index_j[e]]));
+            max_element=max(max_element,abs(inverse[r*N+A->index_j[e]]));
+        }
+    }
+    delete A;
+    return max_error/max_element;
+}
+
+/// Largest difference between the batched inversion of all energies and one call per energy, relative to the largest element
+double check_batch(const std::vector<int> &Bsizes,const std::vector<CPX> &energies)
+{
+    std::vector<CPX> dense;
+    std::vector<TCSR<CPX>*> batched,single;
+    for (uint ie=0;ie<energies.size();ie++) {
+        batched.push_back(block_tridiagonal(Bsizes,energies[ie],dense));
+        single.push_back(block_tridiagonal(Bsizes,energies[ie],dense));
+    }
+    tmprGF::sparse_invert(batched,Bsizes);
+    double max_difference=0.0;
+    double max_element=0.0;
+    for (uint ie=0;ie<energies.size();ie++) {
+        tmprGF::sparse_invert(single[ie],Bsizes);
+        for (int e=0;e<single[ie]->n_nonzeros;e++) {
+            max_difference=max(max_difference,abs(batched[ie]->nnz[e]-single[ie]->nnz[e]));
+            max_element=max(max_element,abs(single[ie]->nnz[e]));
+        }
+        delete batched[ie];
+        delete single[ie];
+    }
+    return max_difference/max_element;
+}
+
+int main(int argc,char **argv)
+{
+    MPI_Init(&argc,&argv);
+    int small[]={3,4,2,5,3};
+    int large[]={6,8,7,9,6,8};
+    std::vector< std::vector<int> > layouts;
+    layouts.push_back(std::vector<int>(small,small+5));
+    layouts.push_back(std::vector<int>(large,large+6));
+    layouts.push_back(std::vector<int>(small,small+5));
+    double max_error=0.0;
+    for (uint il=0;il<layouts.size();il++) {
+        for (int ie=0;ie<4;ie++) {
+            CPX energy=CPX(-1.0+0.5*ie,ie%2 ? 1.0E-3 : 0.5);
+            double error=check_layout(layouts[il],energy);
+            printf("LAYOUT %d ENERGY %g %g RELATIVE ERROR %e\n",il,real(energy),imag(energy),error);
+            max_error=max(max_error,error);
+        }
+    }
+// more energies than OpenMP threads, so the batch is solved in several chunks of one matrix per workspace
+    double max_difference=0.0;
+    for (uint il=0;il<layouts.size();il++) {
+        std::vector<CPX> energies;
+        for (int ie=0;ie<2*omp_get_max_threads()+1;ie++) energies.push_back(CPX(-1.0+0.25*ie,ie%2 ? 1.0E-3 : 0.5));
+        double difference=check_batch(layouts[il],energies);
+        printf("LAYOUT %d BATCH OF %d ENERGIES RELATIVE DIFFERENCE TO SINGLE INVERSIONS %e\n",il,int(energies.size()),difference);
+        max_difference=max(max_difference,difference);
+    }
+    tmprGF::release_workspace();
+    int fail=!(max_error<1.0E-10) || !(max_difference<1.0E-12);
+    printf("RGF CHECK %s, MAX RELATIVE ERROR %e, MAX BATCH DIFFERENCE %e\n",fail ? "FAILED" : "PASSED",max_error,max_difference);
+    MPI_Finalize();
+    return fail;
+}
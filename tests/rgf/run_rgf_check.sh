@@ -0,0 +1,12 @@
+#!/bin/bash -e
+
+# Builds the rGF check against the sources in src, set CXX and LIBS for the local compiler and LAPACK, the batches
+# run on OMP_NUM_THREADS threads
+CXX=${CXX:-mpicxx}
+LIBS=${LIBS:-"-llapack -lblas"}
+SRC=../../src
+
+$CXX -std=c++11 -fopenmp -DAdd_ -I$SRC -o rgf_check rgf_check.cpp $SRC/rGF.C $SRC/tmprGF.C $LIBS
+OMP_NUM_THREADS=${OMP_NUM_THREADS:-3} ./rgf_check
+
+#EOF
@@ -0,0 +1,12 @@
+#!/bin/bash -e
+
+# Builds the band edge check against the sources in src, set CXX and LIBS for the local compiler, ScaLAPACK and LAPACK
+CXX=${CXX:-mpicxx}
+LIBS=${LIBS:-"-lscalapack -llapack -lblas"}
+NP=${NP:-2}
+SRC=../../src
+
+$CXX -std=c++11 -fopenmp -DAdd_ -I$SRC -o singularities_check singularities_check.cpp $SRC/GetSingularities.C $SRC/ParallelEig.C $SRC/Timing.C $LIBS
+mpiexec -np $NP ./singularities_check
+
+#EOF
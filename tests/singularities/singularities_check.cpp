@@ -0,0 +1,143 @@
+/*
+Copyright (c) 2017 ETH Zurich
+Sascha Brueck, Mauro Calderara, Mohammad Hossein Bani-Hashemian, and Mathieu Luisier
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*! \brief Compare the band edges of Singularities::Execute with and without refinement of the k points
+ *
+ *   The lead is a chain of cells with two decoupled orbitals and first and second neighbour couplings, so the bands
+ *   a+2*t1*cos(k)+2*t2*cos(2k) and their edges are known exactly. The edges from 9 uniform k points refined by 3
+ *   bisections of the extrema must be at least as accurate as the ones from 33 uniform k points, and a second call
+ *   must be a band structure cache hit that solves no eigenvalue problem and returns the same edges. The counters of
+ *   every setting are printed, so BANDSTRUCTURE K POINTS shows how many eigenvalue problems each needed.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "GetSingularities.H"
+#include "Timing.H"
+
+const double onsite[2]={-3.0,3.0};
+const double first_neighbour[2]={0.3,-0.2};
+const double second_neighbour[2]={-0.25,0.3};
+
+/// Maximum (sign=1) or minimum (sign=-1) of the band of orbital o over k=0, k=pi and the stationary point in between
+double band_edge(int o,int sign)
+{
+    std::vector<double> cosk;
+    cosk.push_back(1.0);
+    cosk.push_back(-1.0);
+    double stationary=-first_neighbour[o]/(4.0*second_neighbour[o]);
+    if (std::abs(stationary)<1.0) cosk.push_back(stationary);
+    double edge=-sign*1.0E10;
+    for (uint i=0;i<cosk.size();i++) {
+        double energy=onsite[o]+2.0*first_neighbour[o]*cosk[i]+2.0*second_neighbour[o]*(2.0*cosk[i]*cosk[i]-1.0);
+        if (sign*energy>sign*edge) edge=energy;
+    }
+    return edge;
+}
+
+struct edge_error {
+    double vb,cb;
+};
+
+edge_error check_kpoints(cp2k_csr_interop_type H,cp2k_csr_interop_type S,std::vector<contact_type> contactvec,int n_kpoint,int n_kpoint_refine,int &fail)
+{
+    transport_parameters transport_params=transport_parameters();
+    transport_params.real_int_method=real_int_methods::GAUSSCHEBYSHEV;
+    transport_params.eps_singularity_curvatures=1.0E-12;
+    transport_params.eps_mu=1.0E-6;
+    transport_params.temperature=1.0E-3;
+    transport_params.evoltfactor=1.0;
+    transport_params.n_kpoint=n_kpoint;
+    transport_params.n_kpoint_refine=n_kpoint_refine;
+    Timing::Clear();
+    Singularities singularities(transport_params,contactvec);
+    if (singularities.Execute(H,S)) fail=1;
+    double kpoints=Timing::Counter("BANDSTRUCTURE K POINTS");
+    double hits=Timing::Counter("BANDSTRUCTURE CACHE HITS");
+    Singularities cached(transport_params,contactvec);
+    if (cached.Execute(H,S)) fail=1;
+    if (cached.energies_vb[0]!=singularities.energies_vb[0] || cached.energies_cb[0]!=singularities.energies_cb[0]) fail=1;
+// the counters are kept by the first rank only, the second call has to be a cache hit without a single eigenvalue problem
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+    if (!rank && (kpoints<=0.0 || Timing::Counter("BANDSTRUCTURE K POINTS")!=kpoints || Timing::Counter("BANDSTRUCTURE CACHE HITS")<=hits)) fail=1;
+    Timing::Report(n_kpoint*100+n_kpoint_refine);
+    edge_error error;
+    error.vb=std::abs(singularities.energies_vb[0]-band_edge(0,1));
+    error.cb=std::abs(singularities.energies_cb[0]-band_edge(1,-1));
+    return error;
+}
+
+int main(int argc,char **argv)
+{
+    MPI_Init(&argc,&argv);
+    int rank,mpi_size;
+    MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+    MPI_Comm_size(MPI_COMM_WORLD,&mpi_size);
+    int n_cells=20;
+    int ndof=2;
+    int size_tot=n_cells*ndof;
+    int first_row=rank*(size_tot/mpi_size);
+    int nrows_local=rank==mpi_size-1 ? size_tot-first_row : size_tot/mpi_size;
+    std::vector<int> rowptr(1,1),colind,nzerow;
+    std::vector<double> hamiltonian,overlap;
+    for (int i=first_row;i<first_row+nrows_local;i++) {
+        int o=i%ndof;
+        for (int d=-2;d<=2;d++) {
+            int j=i+d*ndof;
+            if (j<0 || j>=size_tot) continue;
+            colind.push_back(j+1);
+            hamiltonian.push_back(d==0 ? onsite[o] : (std::abs(d)==1 ? first_neighbour[o] : second_neighbour[o]));
+            overlap.push_back(d==0 ? 1.0 : 0.0);
+        }
+        rowptr.push_back(colind.size()+1);
+        nzerow.push_back(rowptr.back()-rowptr[rowptr.size()-2]);
+    }
+    cp2k_csr_interop_type H;
+    H.nrows_total  = size_tot;
+    H.ncols_total  = size_tot;
+    H.nze_local    = colind.size();
+    H.nrows_local  = nrows_local;
+    H.first_row    = first_row;
+    H.rowptr_local = &rowptr[0];
+    H.colind_local = &colind[0];
+    H.nzerow_local = &nzerow[0];
+    H.nzvals_local = &hamiltonian[0];
+    H.data_type    = 1;
+    cp2k_csr_interop_type S=H;
+    S.nzvals_local = &overlap[0];
+    contact_type contact;
+    contact.bandwidth = 2;
+    contact.ndof      = ndof;
+    contact.start_bs  = 0;
+    contact.inj_sign  = 1;
+    contact.n_ele     = 2.0;
+    std::vector<contact_type> contactvec(1,contact);
+
+    Timing::enabled=true;
+    int fail=0;
+    int n_kpoint[]={9,9,33,9};
+    int n_kpoint_refine[]={0,3,0,6};
+    std::vector<edge_error> errors;
+    for (int i=0;i<4;i++) {
+        errors.push_back(check_kpoints(H,S,contactvec,n_kpoint[i],n_kpoint_refine[i],fail));
+        if (!rank) printf("N_KPOINT %d N_KPOINT_REFINE %d VALENCE BAND EDGE ERROR %e CONDUCTION BAND EDGE ERROR %e\n",n_kpoint[i],n_kpoint_refine[i],errors[i].vb,errors[i].cb);
+    }
+// 9 points with 3 bisections against 33 uniform points, the relative slack covers the rounding of identical edges
+    if (errors[1].vb>errors[2].vb*(1.0+1.0E-6) || errors[1].cb>errors[2].cb*(1.0+1.0E-6)) fail=1;
+    if (errors[1].vb>=errors[0].vb || errors[1].cb>=errors[0].cb) fail=1;
+    if (errors[3].vb>=errors[1].vb || errors[3].cb>=errors[1].cb) fail=1;
+    MPI_Allreduce(MPI_IN_PLACE,&fail,1,MPI_INT,MPI_MAX,MPI_COMM_WORLD);
+    if (!rank) printf("SINGULARITIES CHECK %s\n",fail ? "FAILED" : "PASSED");
+    MPI_Finalize();
+    return fail;
+}